@@ -0,0 +1,290 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Picked from the compiler's own target macros, as juce_dsp does for JUCE_USE_SIMD. JUCE's
+// JUCE_USE_ARM_NEON is left undefined on Apple targets, which use vDSP instead.
+#if defined (_M_X64) || defined (__amd64__) || defined (__SSE2__) || (defined (_M_IX86_FP) && _M_IX86_FP == 2)
+ #define ROOMBLEED_DELAY_SSE2 1
+ #include <emmintrin.h>
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (__aarch64__) || defined (_M_ARM64)
+ #define ROOMBLEED_DELAY_NEON 1
+ #include <arm_neon.h>
+#endif
+
+// Set to 0 to keep the delay line in 32-bit floats.
+#ifndef ROOMBLEED_COMPACT_DELAY_STORAGE
+ #define ROOMBLEED_COMPACT_DELAY_STORAGE 1
+#endif
+
+// Fractional-delay kernels for CompactDelayLine::read(). Each takes tap(k), the sample k
+// steps older than the current output position, plus a per-channel state slot that
+// only the recursive Thiran kernel uses.
+namespace DelayInterpolation
+{
+    // Rounds to the nearest sample. Cheapest, but zippers while the delay moves.
+    struct None
+    {
+        template <typename Tap>
+        static float process (Tap tap, float delay, float&) { return tap (juce::roundToInt (delay)); }
+    };
+
+    struct Linear
+    {
+        template <typename Tap>
+        static float process (Tap tap, float delay, float&)
+        {
+            const int i = (int) delay;
+            const float frac = delay - (float) i;
+            const float a = tap (i);
+            return a + frac * (tap (i + 1) - a);
+        }
+    };
+
+    // Four taps, with the fraction kept in [1, 2) where the kernel is flattest.
+    struct Lagrange3
+    {
+        template <typename Tap>
+        static float process (Tap tap, float delay, float&)
+        {
+            const int i = delay >= 1.0f ? (int) delay - 1 : 0;
+            const float d = delay - (float) i;
+            const float dm1 = d - 1.0f, dm2 = d - 2.0f, dm3 = d - 3.0f;
+            return tap (i)     * (-dm1 * dm2 * dm3 / 6.0f)
+                 + tap (i + 1) * (d * dm2 * dm3 * 0.5f)
+                 + tap (i + 2) * (-d * dm1 * dm3 * 0.5f)
+                 + tap (i + 3) * (d * dm1 * dm2 / 6.0f);
+        }
+    };
+
+    // First-order allpass: flat magnitude, so no high-frequency loss on static settings,
+    // at the cost of a short transient whenever the integer part of the delay changes.
+    struct Thiran
+    {
+        template <typename Tap>
+        static float process (Tap tap, float delay, float& lastOut)
+        {
+            const int i = juce::jmax (0, (int) (delay - 0.5f));
+            const float d = juce::jmax (0.5f, delay - (float) i);
+            const float eta = (1.0f - d) / (1.0f + d);
+            lastOut = eta * tap (i) + tap (i + 1) - eta * lastOut;
+            return lastOut;
+        }
+    };
+}
+
+// Stereo delay line for the sidechain path. With ROOMBLEED_COMPACT_DELAY_STORAGE the
+// samples are stored as block-companded int16: every 32-sample chunk gets one float
+// scale taken from its peak, so stadium-scale delays take half the memory (and half
+// the cache traffic) of a float buffer at roughly 90 dB below each chunk's peak.
+// Samples are written a whole block at a time and read back through a compile-time
+// interpolation kernel, or decoded straight out when the delay is a steady integer.
+class CompactDelayLine
+{
+public:
+    static constexpr int chunkSize = 32;
+    static constexpr int maxKernelTaps = 4;
+
+    void prepare (int maxDelaySamples, int maxBlockSize)
+    {
+        size = juce::nextPowerOfTwo (maxDelaySamples + maxKernelTaps + maxBlockSize + 2 * chunkSize);
+        mask = size - 1;
+        for (int ch = 0; ch < 2; ++ch) {
+           #if ROOMBLEED_COMPACT_DELAY_STORAGE
+            data[ch].assign ((size_t) size, 0);
+            scales[ch].assign ((size_t) (size / chunkSize), 0.0f);
+            scratch.assign ((size_t) (maxBlockSize + maxKernelTaps + 2 * chunkSize), 0.0f);
+           #else
+            data[ch].assign ((size_t) size, 0.0f);
+           #endif
+        }
+        reset();
+    }
+
+    void reset()
+    {
+        for (int ch = 0; ch < 2; ++ch) {
+            std::fill (data[ch].begin(), data[ch].end(), 0);
+           #if ROOMBLEED_COMPACT_DELAY_STORAGE
+            std::fill (scales[ch].begin(), scales[ch].end(), 0.0f);
+            std::fill (std::begin (staging[ch]), std::end (staging[ch]), 0.0f);
+           #endif
+            kernelState[ch] = 0.0f;
+        }
+        writePos = 0;
+        blockStart = 0;
+    }
+
+    // Appends a block. Reads until the next push are relative to the start of this block.
+    void pushBlock (const float* left, const float* right, int numSamples)
+    {
+        jassert (numSamples + 2 * chunkSize <= size);
+        blockStart = writePos;
+        const float* src[2] = { left, right };
+
+       #if ROOMBLEED_COMPACT_DELAY_STORAGE
+        int done = 0;
+        while (done < numSamples) {
+            const int fill = writePos & (chunkSize - 1);
+            const int n = juce::jmin (numSamples - done, chunkSize - fill);
+            for (int ch = 0; ch < 2; ++ch)
+                std::copy (src[ch] + done, src[ch] + done + n, staging[ch] + fill);
+            done += n;
+            writePos = (writePos + n) & mask;
+
+            if (fill + n == chunkSize) {
+                const int chunk = ((writePos - chunkSize) & mask) / chunkSize;
+                for (int ch = 0; ch < 2; ++ch)
+                    encodeChunk (ch, chunk);
+            }
+        }
+       #else
+        for (int ch = 0; ch < 2; ++ch) {
+            const int first = juce::jmin (numSamples, size - writePos);
+            std::copy (src[ch], src[ch] + first, data[ch].data() + writePos);
+            std::copy (src[ch] + first, src[ch] + numSamples, data[ch].data());
+        }
+        writePos = (writePos + numSamples) & mask;
+       #endif
+    }
+
+    // Reads numSamples of one channel from the last pushed block, each at its own delay.
+    template <typename Kernel>
+    void read (int channel, float* dest, const float* delays, int numSamples)
+    {
+        float& state = kernelState[channel];
+
+       #if ROOMBLEED_COMPACT_DELAY_STORAGE
+        // Each run of outputs has the span of samples its taps can touch decoded into the
+        // scratch first, so the kernels read plain floats. A run ends where that span
+        // would outgrow the scratch, which only happens while the delay moves quickly.
+        const int capacity = (int) scratch.size();
+        int s = 0;
+        while (s < numSamples) {
+            int oldest = oldestTap (s, delays[s]), newest = newestTap (s, delays[s]);
+            int end = s + 1;
+            for (; end < numSamples; ++end) {
+                const int o = juce::jmin (oldest, oldestTap (end, delays[end]));
+                const int w = juce::jmax (newest, newestTap (end, delays[end]));
+                if (w - o + 1 > capacity)
+                    break;
+                oldest = o;
+                newest = w;
+            }
+
+            decode (channel, oldest & mask, newest - oldest + 1, scratch.data());
+            for (; s < end; ++s) {
+                const int position = blockStart + s - oldest;
+                auto tap = [this, position] (int k) { return scratch[(size_t) (position - k)]; };
+                dest[s] = Kernel::process (tap, delays[s], state);
+            }
+        }
+       #else
+        for (int s = 0; s < numSamples; ++s) {
+            const int position = blockStart + s;
+            auto tap = [this, channel, position] (int k) { return data[channel][(size_t) ((position - k) & mask)]; };
+            dest[s] = Kernel::process (tap, delays[s], state);
+        }
+       #endif
+    }
+
+    // Steady integer delay: a straight copy (or chunk decode) of one contiguous run.
+    void readInteger (int channel, float* dest, int delay, int numSamples)
+    {
+        const int index = (blockStart - delay) & mask;
+       #if ROOMBLEED_COMPACT_DELAY_STORAGE
+        decode (channel, index, numSamples, dest);
+       #else
+        const int first = juce::jmin (numSamples, size - index);
+        std::copy (data[channel].data() + index, data[channel].data() + index + first, dest);
+        std::copy (data[channel].data(), data[channel].data() + numSamples - first, dest + first);
+       #endif
+
+        // Keeps the Thiran recursion continuous if the delay starts moving again.
+        if (numSamples > 0)
+            kernelState[channel] = dest[numSamples - 1];
+    }
+
+private:
+   #if ROOMBLEED_COMPACT_DELAY_STORAGE
+    // Unwrapped positions of the oldest and newest sample any kernel reads for output s.
+    int oldestTap (int s, float delay) const { return blockStart + s - ((int) delay + maxKernelTaps); }
+    int newestTap (int s, float delay) const { return blockStart + s - juce::jmax (0, (int) delay - 1); }
+
+    // Decodes numSamples starting at index, wrapping round the buffer, one chunk at a time.
+    void decode (int channel, int index, int numSamples, float* dest) const
+    {
+        int done = 0;
+        while (done < numSamples) {
+            const int offset = index & (chunkSize - 1);
+            const int n = juce::jmin (numSamples - done, chunkSize - offset);
+
+            // The chunk still being filled only exists in the staging buffer.
+            if (index - offset == (writePos & ~(chunkSize - 1)))
+                std::copy (staging[channel] + offset, staging[channel] + offset + n, dest + done);
+            else
+                decodeRun (data[channel].data() + index, scales[channel][(size_t) (index / chunkSize)], dest + done, n);
+
+            done += n;
+            index = (index + n) & mask;
+        }
+    }
+
+    static void decodeRun (const juce::int16* src, float scale, float* dest, int numSamples)
+    {
+        int i = 0;
+       #if ROOMBLEED_DELAY_SSE2
+        const __m128 g = _mm_set1_ps (scale);
+        for (; i + 4 <= numSamples; i += 4) {
+            const __m128i packed = _mm_loadl_epi64 (reinterpret_cast<const __m128i*> (src + i));
+            const __m128i wide = _mm_srai_epi32 (_mm_unpacklo_epi16 (packed, packed), 16);
+            _mm_storeu_ps (dest + i, _mm_mul_ps (_mm_cvtepi32_ps (wide), g));
+        }
+       #elif ROOMBLEED_DELAY_NEON
+        for (; i + 4 <= numSamples; i += 4)
+            vst1q_f32 (dest + i, vmulq_n_f32 (vcvtq_f32_s32 (vmovl_s16 (vld1_s16 (src + i))), scale));
+       #endif
+        for (; i < numSamples; ++i)
+            dest[i] = (float) src[i] * scale;
+    }
+
+    void encodeChunk (int channel, int chunk)
+    {
+        const float* src = staging[channel];
+        juce::int16* dst = data[channel].data() + chunk * chunkSize;
+
+        const auto range = juce::FloatVectorOperations::findMinAndMax (src, chunkSize);
+        const float peak = juce::jmax (-range.getStart(), range.getEnd());
+        scales[channel][(size_t) chunk] = peak / 32767.0f;
+        const float gain = peak > 0.0f ? 32767.0f / peak : 0.0f;
+
+       #if ROOMBLEED_DELAY_SSE2
+        const __m128 g = _mm_set1_ps (gain);
+        for (int i = 0; i < chunkSize; i += 8) {
+            const __m128i lo = _mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i), g));
+            const __m128i hi = _mm_cvtps_epi32 (_mm_mul_ps (_mm_loadu_ps (src + i + 4), g));
+            _mm_storeu_si128 (reinterpret_cast<__m128i*> (dst + i), _mm_packs_epi32 (lo, hi));
+        }
+       #elif ROOMBLEED_DELAY_NEON && (defined (__aarch64__) || defined (_M_ARM64))
+        const float32x4_t g = vdupq_n_f32 (gain);
+        for (int i = 0; i < chunkSize; i += 8) {
+            const int32x4_t lo = vcvtnq_s32_f32 (vmulq_f32 (vld1q_f32 (src + i), g));
+            const int32x4_t hi = vcvtnq_s32_f32 (vmulq_f32 (vld1q_f32 (src + i + 4), g));
+            vst1q_s16 (dst + i, vcombine_s16 (vqmovn_s32 (lo), vqmovn_s32 (hi)));
+        }
+       #else
+        for (int i = 0; i < chunkSize; ++i)
+            dst[i] = (juce::int16) juce::roundToInt (src[i] * gain);
+       #endif
+    }
+
+    std::vector<juce::int16> data[2];
+    std::vector<float> scales[2];
+    std::vector<float> scratch;
+    float staging[2][chunkSize] {};
+   #else
+    std::vector<float> data[2];
+   #endif
+
+    float kernelState[2] {};
+    int size = 0, mask = 0, writePos = 0, blockStart = 0;
+};
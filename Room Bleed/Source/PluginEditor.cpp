@@ -15,7 +15,7 @@ RoomBleedAudioProcessorEditor::RoomBleedAudioProcessorEditor (RoomBleedAudioProc
     };
 
     setupSlider(bleedSlider, "MIX", bleedAtt);
-    setupSlider(spaceSlider, "SPACE", spaceAtt);
+    setupSlider(spaceSlider, audioProcessor.getDistanceParameterID(), spaceAtt);
     setupSlider(locutSlider, "LOCUT", locutAtt);
     setupSlider(hicutSlider, "HICUT", hicutAtt);
 
@@ -37,6 +37,16 @@ RoomBleedAudioProcessorEditor::RoomBleedAudioProcessorEditor (RoomBleedAudioProc
     addAndMakeVisible(roomSelector);
     roomAtt = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, "ROOM", roomSelector);
 
+    // Delay Interpolation Label & Dropdown
+    interpLabel.setText("Interpolation", juce::dontSendNotification);
+    interpLabel.setFont(juce::Font("Helvetica", 14.0f, juce::Font::bold));
+    interpLabel.setColour(juce::Label::textColourId, juce::Colours::white);
+    addAndMakeVisible(interpLabel);
+
+    interpSelector.addItemList({ "Integer", "Linear", "Lagrange", "Thiran" }, 1);
+    addAndMakeVisible(interpSelector);
+    interpAtt = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.treeState, "INTERP", interpSelector);
+
     // Instructions Button (Renamed from Manual)
     instructionsButton.setButtonText("Instructions");
     instructionsButton.onClick = [this]() {
@@ -56,6 +66,13 @@ RoomBleedAudioProcessorEditor::~RoomBleedAudioProcessorEditor()
     outputGainSlider.setLookAndFeel(nullptr);
 }
 
+void RoomBleedAudioProcessorEditor::updateDistanceAttachment()
+{
+    spaceAtt.reset();
+    spaceAtt = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.treeState, audioProcessor.getDistanceParameterID(), spaceSlider);
+    repaint();
+}
+
 void RoomBleedAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // Background and Header
@@ -85,7 +102,7 @@ void RoomBleedAudioProcessorEditor::paint (juce::Graphics& g)
         g.drawText(b, r.getX()-45, r.getBottom()-7, 40, 14, juce::Justification::right);
     };
     drawScale(bleedSlider, "0dB", "-60dB");
-    drawScale(spaceSlider, "50ft", "0ft");
+    drawScale(spaceSlider, audioProcessor.usesLegacySpace() ? "50ft" : "1200ft", "0ft");
     drawScale(locutSlider, "2kHz", "20Hz");
     drawScale(hicutSlider, "20kHz", "500Hz");
 
@@ -123,6 +140,8 @@ void RoomBleedAudioProcessorEditor::resized()
     // Room Selector & Label Positioning
     roomTypeLabel.setBounds(20, 75, 200, 20);
     roomSelector.setBounds(20, 95, 200, 25);
+    interpLabel.setBounds(getWidth() - 170, 75, 150, 20);
+    interpSelector.setBounds(getWidth() - 170, 95, 150, 25);
     
     // Top Right Buttons
     instructionsButton.setBounds(getWidth() - 110, 20, 95, 30);
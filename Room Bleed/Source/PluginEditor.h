@@ -40,17 +40,20 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
+    // Re-points the distance slider after a state load switches between SPACE and DISTANCE.
+    void updateDistanceAttachment();
+
 private:
     RoomBleedAudioProcessor& audioProcessor;
     OutboardLF outboardLF;
 
     juce::Slider bleedSlider, spaceSlider, locutSlider, hicutSlider, outputGainSlider;
-    juce::ComboBox roomSelector;
-    juce::Label roomTypeLabel; // Added Label for Room Type
+    juce::ComboBox roomSelector, interpSelector;
+    juce::Label roomTypeLabel, interpLabel;
     juce::TextButton instructionsButton;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> bleedAtt, spaceAtt, locutAtt, hicutAtt, gainAtt;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> roomAtt;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> roomAtt, interpAtt;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RoomBleedAudioProcessorEditor)
 };
@@ -1,6 +1,11 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+// Plugin builds get this from JucePluginDefines.h; the stress host compiles this file without it.
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name "Room Bleed"
+#endif
+
 RoomBleedAudioProcessor::RoomBleedAudioProcessor()
      : AudioProcessor (BusesProperties()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
@@ -10,16 +15,113 @@ RoomBleedAudioProcessor::RoomBleedAudioProcessor()
 {
 }
 
-RoomBleedAudioProcessor::~RoomBleedAudioProcessor() {}
+RoomBleedAudioProcessor::~RoomBleedAudioProcessor()
+{
+    cancelPendingUpdate();
+    delete activeEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+}
 
-void RoomBleedAudioProcessor::reset()
+void RoomBleedAudioProcessor::BleedEngine::prepare (const juce::dsp::ProcessSpec& spec)
+{
+    delayLine.prepare((int)std::ceil(maxDistanceFt / speedOfSoundFtPerSec * spec.sampleRate) + 2, (int)spec.maximumBlockSize);
+    lowcutFilter.prepare(spec);
+    lowcutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
+    hicutFilter.prepare(spec);
+    hicutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+    airAbsorptionFilter.prepare(spec);
+    airAbsorptionFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+
+    for (int i = 0; i < (int)reverbStages.size(); ++i)
+        reverbStages[(size_t)i].prepare(spec, i);
+    for (auto& bank : resonatorBanks)
+        bank.prepare(spec);
+    activeReverbStage = 0;
+    fadeLength = juce::jmax(1, (int)(spec.sampleRate * stageFadeSeconds));
+
+    bleedBuffer.setSize(2, (int)spec.maximumBlockSize);
+    drainBuffer.setSize(2, (int)spec.maximumBlockSize);
+    delayModulation.setSize(2, (int)spec.maximumBlockSize);
+
+    delaySmoother.reset(spec.sampleRate, 0.1);
+    distanceAttenuation.reset(spec.sampleRate, 0.1);
+    reset();
+}
+
+void RoomBleedAudioProcessor::BleedEngine::reset()
 {
     delayLine.reset();
-    reverb.reset();
+    for (auto& r : reverbStages)
+        r.reset();
+    for (auto& bank : resonatorBanks)
+        bank.reset();
+    drainingReverbStage = fadingReverbStage = -1;
     lowcutFilter.reset();
     hicutFilter.reset();
     airAbsorptionFilter.reset();
     bleedBuffer.clear();
+    drainBuffer.clear();
+    primed = false;
+}
+
+void RoomBleedAudioProcessor::BleedEngine::resetStage (int stage)
+{
+    if (isModalStage(stage))
+        resonatorBanks[(size_t)(stage - modalStage)].reset();
+    else if (stage != dryStage)
+        reverbStages[(size_t)stage].reset();
+}
+
+void RoomBleedAudioProcessor::BleedEngine::switchStage (int stage, const ResonatorPreset* preset)
+{
+    if (stage == activeReverbStage)
+        return;
+
+    // Going back to the stage that is still ringing out just picks its live state back up.
+    if (stage == drainingReverbStage) {
+        std::swap(activeReverbStage, drainingReverbStage);
+        return;
+    }
+
+    // A tail still draining hands its slot over and fades out quickly instead. One caught
+    // mid-fade by yet another switch is at most stageFadeSeconds from silence and is cut.
+    if (stage == fadingReverbStage)
+        fadingReverbStage = -1;
+    if (drainingReverbStage >= 0) {
+        if (fadingReverbStage >= 0)
+            resetStage(fadingReverbStage);
+        fadingReverbStage = drainingReverbStage;
+        fadeSamplesLeft = fadeLength;
+    }
+
+    drainingReverbStage = activeReverbStage;
+    activeReverbStage = stage;
+    if (preset != nullptr)
+        resonatorBanks[(size_t)(stage - modalStage)].setPreset(*preset);
+    resetStage(stage);
+}
+
+void RoomBleedAudioProcessor::BleedEngine::processStage (int stage, juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (isModalStage(stage))
+        resonatorBanks[(size_t)(stage - modalStage)].process(buffer, numSamples);
+    else if (stage == dryStage)
+        buffer.applyGain(0, numSamples, 2.0f); // what juce::Reverb's dry path gives at dryLevel 1
+    else
+        reverbStages[(size_t)stage].process(buffer, numSamples);
+}
+
+int RoomBleedAudioProcessor::BleedEngine::getStageLatency (int stage) const
+{
+    return stage < (int)reverbStages.size() ? reverbStages[(size_t)stage].getLatencySamples() : 0;
+}
+
+void RoomBleedAudioProcessor::reset()
+{
+    if (auto* engine = activeEngine.load())
+        engine->reset();
+    idleSamples = 0;
+    onsetWrite = onsetCount = 0;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout RoomBleedAudioProcessor::createParameterLayout()
@@ -29,44 +131,124 @@ juce::AudioProcessorValueTreeState::ParameterLayout RoomBleedAudioProcessor::cre
     params.push_back(std::make_unique<juce::AudioParameterFloat>("MIX", "Mix", -60.0f, 0.0f, -6.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("LOCUT", "Low-cut", juce::NormalisableRange<float>(20.0f, 2000.0f, 1.0f, 0.3f), 20.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("HICUT", "Hi-cut", juce::NormalisableRange<float>(500.0f, 20000.0f, 1.0f, 0.3f), 20000.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("SPACE", "Distance", 0.0f, 50.0f, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("SPACE", "Distance", 0.0f, legacyMaxDistanceFt, 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("EXTRAGAIN", "Extra Gain", 0.0f, 10.0f, 0.0f));
     
     // "None" added to the beginning. Total of 21 options now.
     juce::StringArray roomChoices { "None", "Living Room", "Studio", "Garage", "Concert Hall", "Club", "Parking Garage", "Football Field", "Arena", "Hallway", "Bathroom", "Small Closet", "Large Ballroom", "Outer Space", "Phone Booth", "Concrete Pipe", "Deep Well", "Cathedral", "Inside a Guitar", "Nuclear Silo", "Underwater" };
     params.push_back(std::make_unique<juce::AudioParameterChoice>("ROOM", "Room Type", roomChoices, 1)); // Defaults to "Living Room"
+
+    // Added after 1.1.1. Hosts that address parameters by index need new ones appended,
+    // never inserted. DISTANCE is a new ID rather than a wider SPACE so automation written
+    // against the old 0-50 ft range keeps its meaning.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("DISTANCE", "Distance (Long)", juce::NormalisableRange<float>(0.0f, maxDistanceFt, 0.0f, 0.3f), 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("INTERP", "Delay Interpolation", juce::StringArray { "Integer", "Linear", "Lagrange", "Thiran" }, 1));
     
     return { params.begin(), params.end() };
 }
 
 void RoomBleedAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = (juce::uint32)samplesPerBlock;
-    spec.numChannels = 2;
+    const juce::ScopedLock sl (engineLock);
 
-    delayLine.prepare(spec);
-    lowcutFilter.prepare(spec);
-    lowcutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    hicutFilter.prepare(spec);
-    hicutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
-    airAbsorptionFilter.prepare(spec);
-    airAbsorptionFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+    preparedSpec.sampleRate = sampleRate;
+    preparedSpec.maximumBlockSize = (juce::uint32)samplesPerBlock;
+    preparedSpec.numChannels = 2;
+    isPrepared = true;
+
+    // Playback is stopped here, so an existing engine can be resized in place. Offline
+    // renders get their engine now rather than on the first hit, as does a request that
+    // arrived before the first prepare. Everything else waits for sidechain signal; an
+    // enabled bus only gets the small onset ring so that first hit isn't lost.
+    auto* sidechainBus = getBus(true, 1);
+    const bool sidechainEnabled = sidechainBus != nullptr && sidechainBus->isEnabled();
+    if (isNonRealtime())
+        engineRequested = true;
+
+    delete retiredEngine.exchange(nullptr);
+    auto* engine = activeEngine.load();
+    if (engine == nullptr && engineRequested.load()) {
+        engine = new BleedEngine();
+        activeEngine.store(engine);
+    }
+    if (engine != nullptr)
+        engine->prepare(preparedSpec);
+
+    onsetBuffer.setSize(2, sidechainEnabled ? (int)(sampleRate * onsetBufferSeconds) : 0);
 
-    reverb.prepare(spec);
-    bleedBuffer.setSize(2, samplesPerBlock);
-    
     mixGain.reset(sampleRate, 0.05);
-    delaySmoother.reset(sampleRate, 0.1);
-    distanceAttenuation.reset(sampleRate, 0.1);
     extraSidechainGain.reset(sampleRate, 0.05);
     reset();
 }
 
-void RoomBleedAudioProcessor::updateRoomProfile()
+void RoomBleedAudioProcessor::releaseResources()
+{
+    const juce::ScopedLock sl (engineLock);
+    isPrepared = false;
+    engineRequested = false;
+    delete activeEngine.exchange(nullptr);
+    delete retiredEngine.exchange(nullptr);
+}
+
+void RoomBleedAudioProcessor::handleAsyncUpdate()
+{
+    const juce::ScopedLock sl (engineLock);
+    delete retiredEngine.exchange(nullptr);
+
+    if (isPrepared && engineRequested.load() && activeEngine.load() == nullptr) {
+        auto engine = std::make_unique<BleedEngine>();
+        engine->prepare(preparedSpec);
+        activeEngine.store(engine.release());
+    }
+}
+
+const ResonatorPreset* RoomBleedAudioProcessor::getResonatorPreset (int roomType)
+{
+    // { frequency Hz, T60 s, gain }. Box modes for the booth and closet, longitudinal plus
+    // cross-section modes for the pipe, cross-section modes split by the shaft for the well.
+    static const ResonatorPreset phoneBooth { {
+        { 78.0f, 0.41f, 1.00f }, { 156.0f, 0.38f, 1.00f }, { 191.0f, 0.36f, 1.00f }, { 206.0f, 0.36f, 1.00f },
+        { 234.0f, 0.35f, 1.00f }, { 246.0f, 0.34f, 1.00f }, { 269.0f, 0.34f, 0.70f }, { 281.0f, 0.33f, 0.50f },
+        { 302.0f, 0.33f, 1.00f }, { 311.0f, 0.32f, 0.50f }, { 343.0f, 0.31f, 1.00f }, { 357.0f, 0.31f, 0.50f },
+        { 365.0f, 0.31f, 1.00f }, { 381.0f, 0.30f, 1.00f }, { 389.0f, 0.30f, 1.00f }, { 468.0f, 0.28f, 0.70f } },
+        0.18f, 0.35f, 0.35f };
+    static const ResonatorPreset smallCloset { {
+        { 71.0f, 0.13f, 1.00f }, { 143.0f, 0.12f, 1.00f }, { 160.0f, 0.12f, 0.70f }, { 191.0f, 0.11f, 1.00f },
+        { 202.0f, 0.11f, 0.70f }, { 204.0f, 0.11f, 0.70f }, { 214.0f, 0.11f, 1.00f }, { 238.0f, 0.11f, 1.00f },
+        { 249.0f, 0.11f, 0.50f }, { 258.0f, 0.11f, 0.70f }, { 278.0f, 0.10f, 0.50f }, { 286.0f, 0.10f, 1.00f },
+        { 287.0f, 0.10f, 0.70f }, { 295.0f, 0.10f, 0.70f }, { 320.0f, 0.10f, 1.00f }, { 344.0f, 0.10f, 1.00f } },
+        0.12f, 0.25f, 0.12f };
+    static const ResonatorPreset concretePipe { {
+        { 29.0f, 1.77f, 1.00f }, { 57.0f, 1.73f, 1.00f }, { 86.0f, 1.70f, 1.00f }, { 114.0f, 1.67f, 1.00f },
+        { 143.0f, 1.64f, 1.00f }, { 172.0f, 1.62f, 1.00f }, { 200.0f, 1.59f, 1.00f }, { 223.0f, 1.57f, 0.70f },
+        { 229.0f, 1.56f, 1.00f }, { 370.0f, 1.44f, 0.70f }, { 465.0f, 1.37f, 0.70f }, { 510.0f, 1.34f, 0.70f },
+        { 645.0f, 1.26f, 0.70f }, { 647.0f, 1.26f, 0.70f }, { 778.0f, 1.19f, 0.70f }, { 814.0f, 1.17f, 0.70f } },
+        0.32f, 0.50f, 1.40f };
+    static const ResonatorPreset deepWell { {
+        { 134.0f, 2.75f, 1.00f }, { 136.0f, 2.75f, 0.70f }, { 139.0f, 2.74f, 0.70f }, { 145.0f, 2.74f, 0.70f },
+        { 222.0f, 2.61f, 0.80f }, { 223.0f, 2.61f, 0.56f }, { 226.0f, 2.61f, 0.56f }, { 229.0f, 2.60f, 0.56f },
+        { 279.0f, 2.53f, 0.70f }, { 280.0f, 2.53f, 0.49f }, { 282.0f, 2.53f, 0.49f }, { 284.0f, 2.52f, 0.49f },
+        { 306.0f, 2.49f, 0.60f }, { 307.0f, 2.49f, 0.42f }, { 308.0f, 2.49f, 0.42f }, { 311.0f, 2.49f, 0.42f } },
+        0.38f, 0.60f, 2.60f };
+    static const ResonatorPreset insideGuitar { {
+        { 98.0f, 0.25f, 1.00f }, { 200.0f, 0.18f, 0.90f }, { 230.0f, 0.16f, 0.60f }, { 290.0f, 0.14f, 0.50f },
+        { 357.0f, 0.14f, 0.70f }, { 410.0f, 0.12f, 0.50f }, { 451.0f, 0.12f, 0.60f }, { 520.0f, 0.11f, 0.40f },
+        { 580.0f, 0.10f, 0.40f }, { 714.0f, 0.10f, 0.50f }, { 750.0f, 0.09f, 0.30f }, { 850.0f, 0.09f, 0.30f },
+        { 950.0f, 0.08f, 0.30f }, { 1100.0f, 0.08f, 0.25f }, { 1250.0f, 0.07f, 0.20f }, { 1450.0f, 0.06f, 0.20f } },
+        0.96f, 0.20f, 0.20f };
+
+    switch (roomType) {
+        case 11: return &smallCloset;
+        case 14: return &phoneBooth;
+        case 15: return &concretePipe;
+        case 16: return &deepWell;
+        case 18: return &insideGuitar;
+        default: return nullptr;
+    }
+}
+
+void RoomBleedAudioProcessor::updateRoomProfile (BleedEngine& engine, int type)
 {
-    int type = static_cast<int>(treeState.getRawParameterValue("ROOM")->load());
     juce::dsp::Reverb::Parameters p;
     
     if (type == 0) {
@@ -101,57 +283,290 @@ void RoomBleedAudioProcessor::updateRoomProfile()
             case 20: p.roomSize = 0.62f; p.damping = 1.00f; p.width = 0.38f; break; // Underwater
         }
     }
-    reverb.setParameters(p);
+    for (auto& r : engine.reverbStages)
+        r.setParameters(p);
+}
+
+int RoomBleedAudioProcessor::chooseReverbStage (const BleedEngine& engine, float hiCutHz) const
+{
+    // Each halfband stage is flat up to 0.2 of its input rate. Only HICUT counts, not the
+    // air-absorption cutoff, so moving SPACE never changes the rate. Going further down
+    // than the current stage needs a 30% margin so HICUT automation doesn't chatter.
+    const float sr = (float)getSampleRate();
+    int stage = 0;
+    while (stage < (int)engine.reverbStages.size() - 1) {
+        float limit = 0.2f * sr / (float)(1 << stage);
+        if (stage >= engine.activeReverbStage) limit *= 0.7f;
+        if (hiCutHz > limit) break;
+        ++stage;
+    }
+    return stage;
+}
+
+int RoomBleedAudioProcessor::chooseModalStage (const BleedEngine& engine, const ResonatorPreset& preset)
+{
+    // Stay on a bank that is playing or ringing out with this preset; otherwise take one
+    // that is doing neither. If all three are busy, the one fading out is given up.
+    for (int stage : { engine.activeReverbStage, engine.drainingReverbStage })
+        if (isModalStage(stage) && engine.resonatorBanks[(size_t)(stage - modalStage)].getPreset() == &preset)
+            return stage;
+
+    for (int stage = modalStage; stage < dryStage; ++stage)
+        if (stage != engine.activeReverbStage && stage != engine.drainingReverbStage && stage != engine.fadingReverbStage)
+            return stage;
+    return engine.fadingReverbStage;
+}
+
+void RoomBleedAudioProcessor::processReverb (BleedEngine& e, int numSamples)
+{
+    e.processStage(e.activeReverbStage, e.bleedBuffer, numSamples);
+
+    // The stage switched away from is fed silence and rings out on top of the new one,
+    // so its tail carries on as a single reverb's would instead of being cut.
+    if (e.drainingReverbStage >= 0) {
+        e.drainBuffer.clear();
+        e.processStage(e.drainingReverbStage, e.drainBuffer, numSamples);
+
+        bool drained = true;
+        for (int ch = 0; ch < 2; ++ch) {
+            e.bleedBuffer.addFrom(ch, 0, e.drainBuffer, ch, 0, numSamples);
+            drained = drained && e.drainBuffer.getMagnitude(ch, 0, numSamples) < silenceThreshold;
+        }
+        if (drained)
+            e.drainingReverbStage = -1;
+    }
+
+    if (e.fadingReverbStage >= 0) {
+        e.drainBuffer.clear();
+        e.processStage(e.fadingReverbStage, e.drainBuffer, numSamples);
+
+        const int fadeEnd = juce::jmax(0, e.fadeSamplesLeft - numSamples);
+        const float startGain = (float)e.fadeSamplesLeft / (float)e.fadeLength;
+        const float endGain = (float)fadeEnd / (float)e.fadeLength;
+        const int n = juce::jmin(numSamples, e.fadeSamplesLeft);
+        for (int ch = 0; ch < 2; ++ch)
+            e.bleedBuffer.addFromWithRamp(ch, 0, e.drainBuffer.getReadPointer(ch), n, startGain, endGain);
+
+        e.fadeSamplesLeft = fadeEnd;
+        if (fadeEnd == 0) {
+            e.resetStage(e.fadingReverbStage);
+            e.fadingReverbStage = -1;
+        }
+    }
 }
 
+void RoomBleedAudioProcessor::readDelayed (BleedEngine& e, int interpolation, int numSamples)
+{
+    float* delays = e.delayModulation.getWritePointer(0);
+    float* gains = e.delayModulation.getWritePointer(1);
+    for (int s = 0; s < numSamples; ++s) {
+        delays[s] = e.delaySmoother.getNextValue();
+        gains[s] = e.distanceAttenuation.getNextValue();
+    }
+
+    for (int ch = 0; ch < 2; ++ch) {
+        float* dest = e.bleedBuffer.getWritePointer(ch);
+        switch (interpolation) {
+            case 0:  e.delayLine.read<DelayInterpolation::None>(ch, dest, delays, numSamples); break;
+            case 2:  e.delayLine.read<DelayInterpolation::Lagrange3>(ch, dest, delays, numSamples); break;
+            case 3:  e.delayLine.read<DelayInterpolation::Thiran>(ch, dest, delays, numSamples); break;
+            default: e.delayLine.read<DelayInterpolation::Linear>(ch, dest, delays, numSamples); break;
+        }
+        juce::FloatVectorOperations::multiply(dest, gains, numSamples);
+    }
+}
+
+void RoomBleedAudioProcessor::recordOnset (const juce::AudioBuffer<float>& sidechain, int numSamples)
+{
+    const int capacity = onsetBuffer.getNumSamples();
+    if (capacity == 0 || sidechain.getNumChannels() == 0)
+        return;
+
+    // Ring buffer: only the newest capacity samples are kept.
+    int s = juce::jmax(0, numSamples - capacity);
+    onsetCount = juce::jmin(capacity, onsetCount + numSamples - s);
+    while (s < numSamples) {
+        int n = juce::jmin(numSamples - s, capacity - onsetWrite);
+        for (int ch = 0; ch < 2; ++ch)
+            onsetBuffer.copyFrom(ch, onsetWrite, sidechain, juce::jmin(ch, sidechain.getNumChannels() - 1), s, n);
+        onsetWrite = (onsetWrite + n) % capacity;
+        s += n;
+    }
+}
+
+void RoomBleedAudioProcessor::replayOnset (BleedEngine& e)
+{
+    // Pushed oldest first, ahead of the current block, so the captured audio sits at its
+    // true age in the delay line and comes out when its distance says it should.
+    const int capacity = onsetBuffer.getNumSamples();
+    int index = (onsetWrite - onsetCount + capacity) % juce::jmax(1, capacity);
+    while (onsetCount > 0) {
+        int n = juce::jmin(onsetCount, capacity - index, (int)preparedSpec.maximumBlockSize);
+        e.delayLine.pushBlock(onsetBuffer.getReadPointer(0, index), onsetBuffer.getReadPointer(1, index), n);
+        index = (index + n) % capacity;
+        onsetCount -= n;
+    }
+    onsetWrite = 0;
+}
+
+#if ROOMBLEED_PROFILE
+void RoomBleedAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    const auto start = juce::Time::getHighResolutionTicks();
+    processBlockInternal(buffer);
+    const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+    timedBlocks.fetch_add(1, std::memory_order_relaxed);
+    totalTicks.fetch_add(elapsed, std::memory_order_relaxed);
+    if (elapsed > worstTicks.load(std::memory_order_relaxed))
+        worstTicks.store(elapsed, std::memory_order_relaxed);
+}
+
+RoomBleedAudioProcessor::BlockTimingStats RoomBleedAudioProcessor::getBlockTimingStats() const
+{
+    BlockTimingStats stats;
+    stats.numBlocks = timedBlocks.load();
+    stats.totalSeconds = juce::Time::highResolutionTicksToSeconds(totalTicks.load());
+    stats.worstSeconds = juce::Time::highResolutionTicksToSeconds(worstTicks.load());
+    return stats;
+}
+
+void RoomBleedAudioProcessor::resetBlockTimingStats()
+{
+    timedBlocks = 0;
+    totalTicks = 0;
+    worstTicks = 0;
+}
+
+void RoomBleedAudioProcessor::processBlockInternal (juce::AudioBuffer<float>& buffer)
+#else
 void RoomBleedAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+#endif
 {
     juce::ScopedNoDenormals noDenormals;
     auto sidechainBuffer = getBusBuffer(buffer, true, 1);
     int numSamples = buffer.getNumSamples();
-    bleedBuffer.clear();
 
-    if (sidechainBuffer.getNumChannels() > 0) {
-        float distFt = treeState.getRawParameterValue("SPACE")->load();
-        
-        float delaySamples = (distFt / 1130.0f) * (float)getSampleRate();
-        delaySmoother.setTargetValue(delaySamples);
-        
-        float atten = 1.0f / (1.0f + distFt);
-        distanceAttenuation.setTargetValue(atten);
+    bool sidechainActive = false;
+    for (int ch = 0; ch < sidechainBuffer.getNumChannels(); ++ch)
+        sidechainActive = sidechainActive || sidechainBuffer.getMagnitude(ch, 0, numSamples) > silenceThreshold;
+
+    auto* engine = activeEngine.load();
+    if (engine == nullptr) {
+        if (sidechainActive && isNonRealtime()) {
+            // Offline renders may block, so the engine is built right here.
+            engineRequested = true;
+            handleAsyncUpdate();
+            engine = activeEngine.load();
+        } else if (sidechainActive && ! engineRequested.exchange(true)) {
+            triggerAsyncUpdate();
+        }
+        if (engine == nullptr && engineRequested.load())
+            recordOnset(sidechainBuffer, numSamples);
+    } else {
+        const int releaseSamples = (int)(getSampleRate() * engineReleaseSeconds);
+        idleSamples = sidechainActive ? 0 : juce::jmin(idleSamples + numSamples, releaseSamples);
+
+        // A quiet sidechain mid-take is just a rest, so only a disabled bus or a stopped
+        // transport lets the engine go. Without position info the host counts as playing.
+        bool canRelease = false;
+        if (idleSamples >= releaseSamples && ! isNonRealtime()) {
+            canRelease = sidechainBuffer.getNumChannels() == 0;
+            if (! canRelease)
+                if (auto* playHead = getPlayHead())
+                    if (auto position = playHead->getPosition())
+                        canRelease = ! position->getIsPlaying();
+        }
+
+        if (canRelease && retiredEngine.load() == nullptr) {
+            // Long silence: hand the engine to the message thread to be freed.
+            activeEngine.store(nullptr);
+            retiredEngine.store(engine);
+            engineRequested = false;
+            idleSamples = 0;
+            engine = nullptr;
+            triggerAsyncUpdate();
+        }
+    }
+
+    if (engine != nullptr)
+        engine->bleedBuffer.clear();
+
+    if (engine != nullptr && sidechainBuffer.getNumChannels() > 0) {
+        auto& e = *engine;
+        float distFt = treeState.getRawParameterValue(legacySpace.load() ? "SPACE" : "DISTANCE")->load();
 
         float airCutoff = 20000.0f / (1.0f + (distFt * 0.15f));
-        airAbsorptionFilter.setCutoffFrequency(juce::jlimit(20.0f, 20000.0f, airCutoff));
+        e.airAbsorptionFilter.setCutoffFrequency(juce::jlimit(20.0f, 20000.0f, airCutoff));
 
-        lowcutFilter.setCutoffFrequency(treeState.getRawParameterValue("LOCUT")->load());
-        hicutFilter.setCutoffFrequency(treeState.getRawParameterValue("HICUT")->load());
+        float hiCut = treeState.getRawParameterValue("HICUT")->load();
+        e.lowcutFilter.setCutoffFrequency(treeState.getRawParameterValue("LOCUT")->load());
+        e.hicutFilter.setCutoffFrequency(hiCut);
         
-        updateRoomProfile();
+        int roomType = static_cast<int>(treeState.getRawParameterValue("ROOM")->load());
+        updateRoomProfile(e, roomType);
 
-        for (int s = 0; s < numSamples; ++s) {
-            delayLine.setDelay(delaySmoother.getNextValue());
-            float curDistGain = distanceAttenuation.getNextValue();
-            for (int ch = 0; ch < 2; ++ch) {
-                float scIn = sidechainBuffer.getSample(juce::jmin(ch, sidechainBuffer.getNumChannels() - 1), s);
-                delayLine.pushSample(ch, scIn);
-                float sig = delayLine.popSample(ch) * curDistGain;
-                sig = airAbsorptionFilter.processSample(ch, sig);
-                sig = lowcutFilter.processSample(ch, sig);
-                sig = hicutFilter.processSample(ch, sig);
-                bleedBuffer.setSample(ch, s, sig);
+        auto* preset = getResonatorPreset(roomType);
+        int stage = roomType == 0 ? dryStage
+                  : preset != nullptr ? chooseModalStage(e, *preset)
+                  : chooseReverbStage(e, hiCut);
+        e.switchStage(stage, preset);
+
+        // Whole samples only, so a settled distance lands on the integer-delay fast path.
+        // The active stage's resampling latency comes off the top so SPACE stays in feet.
+        float delaySamples = std::round((distFt / speedOfSoundFtPerSec) * (float)getSampleRate());
+        delaySamples = juce::jmax(0.0f, delaySamples - (float)e.getStageLatency(e.activeReverbStage));
+        float atten = 1.0f / (1.0f + distFt);
+        if (! e.primed) {
+            e.delaySmoother.setCurrentAndTargetValue(delaySamples);
+            e.distanceAttenuation.setCurrentAndTargetValue(atten);
+            e.primed = true;
+        }
+        e.delaySmoother.setTargetValue(delaySamples);
+        e.distanceAttenuation.setTargetValue(atten);
+
+        if (onsetCount > 0)
+            replayOnset(e);
+        e.delayLine.pushBlock(sidechainBuffer.getReadPointer(0),
+                              sidechainBuffer.getReadPointer(juce::jmin(1, sidechainBuffer.getNumChannels() - 1)),
+                              numSamples);
+
+        if (! e.delaySmoother.isSmoothing() && ! e.distanceAttenuation.isSmoothing()) {
+            int delayInt = juce::roundToInt(e.delaySmoother.getCurrentValue());
+            for (int ch = 0; ch < 2; ++ch)
+                e.delayLine.readInteger(ch, e.bleedBuffer.getWritePointer(ch), delayInt, numSamples);
+            e.bleedBuffer.applyGain(0, numSamples, e.distanceAttenuation.getCurrentValue());
+        } else {
+            readDelayed(e, static_cast<int>(treeState.getRawParameterValue("INTERP")->load()), numSamples);
+        }
+
+        for (int ch = 0; ch < 2; ++ch) {
+            float* sig = e.bleedBuffer.getWritePointer(ch);
+            for (int s = 0; s < numSamples; ++s) {
+                float x = e.airAbsorptionFilter.processSample(ch, sig[s]);
+                x = e.lowcutFilter.processSample(ch, x);
+                sig[s] = e.hicutFilter.processSample(ch, x);
             }
         }
-        juce::dsp::AudioBlock<float> block(bleedBuffer);
-        reverb.process(juce::dsp::ProcessContextReplacing<float>(block));
+        processReverb(e, numSamples);
     }
 
     mixGain.setTargetValue(juce::Decibels::decibelsToGain(treeState.getRawParameterValue("MIX")->load()));
     float extraDb = treeState.getRawParameterValue("EXTRAGAIN")->load();
     extraSidechainGain.setTargetValue(juce::Decibels::decibelsToGain(extraDb));
 
+    if (engine == nullptr) {
+        // No bleed to add; keep the output clamp the wet path applies.
+        mixGain.skip(numSamples);
+        extraSidechainGain.skip(numSamples);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            juce::FloatVectorOperations::clip(buffer.getWritePointer(ch), buffer.getReadPointer(ch), -1.0f, 1.0f, numSamples);
+        return;
+    }
+
     for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
         float* mainOut = buffer.getWritePointer(ch);
-        const float* wetSrc = bleedBuffer.getReadPointer(juce::jmin(ch, 1));
+        const float* wetSrc = engine->bleedBuffer.getReadPointer(juce::jmin(ch, 1));
         for (int s = 0; s < numSamples; ++s) {
             float wetContribution = wetSrc[s] * mixGain.getNextValue() * extraSidechainGain.getNextValue();
             mainOut[s] = juce::jlimit(-1.0f, 1.0f, mainOut[s] + wetContribution);
@@ -172,7 +587,23 @@ int RoomBleedAudioProcessor::getCurrentProgram() { return 0; }
 void RoomBleedAudioProcessor::setCurrentProgram (int index) {}
 const juce::String RoomBleedAudioProcessor::getProgramName (int index) { return {}; }
 void RoomBleedAudioProcessor::changeProgramName (int index, const juce::String& newName) {}
-void RoomBleedAudioProcessor::releaseResources() {}
 bool RoomBleedAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const { return true; }
 void RoomBleedAudioProcessor::getStateInformation (juce::MemoryBlock& d) { auto s = treeState.copyState(); std::unique_ptr<juce::XmlElement> x (s.createXml()); copyXmlToBinary (*x, d); }
-void RoomBleedAudioProcessor::setStateInformation (const void* d, int s) { std::unique_ptr<juce::XmlElement> x (getXmlFromBinary (d, s)); if (x != nullptr) treeState.replaceState (juce::ValueTree::fromXml (*x)); }
+
+void RoomBleedAudioProcessor::setStateInformation (const void* d, int s)
+{
+    std::unique_ptr<juce::XmlElement> x (getXmlFromBinary (d, s));
+    if (x == nullptr)
+        return;
+
+    // A state without DISTANCE predates the long range: mark it so it stays on SPACE.
+    auto state = juce::ValueTree::fromXml (*x);
+    if (! state.hasProperty ("legacySpace"))
+        state.setProperty ("legacySpace", ! state.getChildWithProperty ("id", "DISTANCE").isValid(), nullptr);
+    legacySpace = (bool) state.getProperty ("legacySpace");
+    treeState.replaceState (state);
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        if (auto* editor = dynamic_cast<RoomBleedAudioProcessorEditor*> (getActiveEditor()))
+            editor->updateDistanceAttachment();
+}
@@ -1,7 +1,17 @@
 #pragma once
 #include <JuceHeader.h>
+#include "CompactDelayLine.h"
+#include "ReducedRateReverb.h"
+#include "ResonatorBank.h"
 
-class RoomBleedAudioProcessor  : public juce::AudioProcessor
+// Set to 1 to have each instance time its own processBlock calls, for session-scale
+// stress hosts such as StressHost/. Off by default: it adds two clock reads per block.
+#ifndef ROOMBLEED_PROFILE
+ #define ROOMBLEED_PROFILE 0
+#endif
+
+class RoomBleedAudioProcessor  : public juce::AudioProcessor,
+                                 private juce::AsyncUpdater
 {
 public:
     RoomBleedAudioProcessor();
@@ -34,15 +44,106 @@ public:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState treeState;
 
+    // True once the sidechain has carried signal and the bleed DSP state is allocated.
+    bool hasActiveEngine() const { return activeEngine.load() != nullptr; }
+
+    // Sessions saved before DISTANCE existed keep running on the 0-50 ft SPACE parameter,
+    // so their normalised automation still lands on the same distances.
+    bool usesLegacySpace() const { return legacySpace.load(); }
+    juce::String getDistanceParameterID() const { return usesLegacySpace() ? "SPACE" : "DISTANCE"; }
+
+   #if ROOMBLEED_PROFILE
+    struct BlockTimingStats
+    {
+        juce::int64 numBlocks = 0;
+        double totalSeconds = 0.0, worstSeconds = 0.0;
+    };
+
+    // Safe to call from any thread while audio is running; values are read individually.
+    BlockTimingStats getBlockTimingStats() const;
+    void resetBlockTimingStats();
+   #endif
+
 private:
-    void updateRoomProfile();
-    
-    juce::dsp::DelayLine<float> delayLine { 192000 };
-    juce::dsp::StateVariableTPTFilter<float> lowcutFilter, hicutFilter, airAbsorptionFilter;
-    juce::dsp::Reverb reverb;
-    
-    juce::AudioBuffer<float> bleedBuffer;
-    juce::SmoothedValue<float> mixGain, delaySmoother, distanceAttenuation, extraSidechainGain;
+    static constexpr float maxDistanceFt = 1200.0f;
+    static constexpr float legacyMaxDistanceFt = 50.0f;
+    static constexpr float speedOfSoundFtPerSec = 1130.0f;
+
+    static constexpr float silenceThreshold = 1.0e-5f;
+    static constexpr double engineReleaseSeconds = 60.0;
+    static constexpr double onsetBufferSeconds = 0.2;
+    static constexpr int modalStage = 3; // first of the three resonator banks
+    static constexpr int dryStage = 6;
+    static constexpr double stageFadeSeconds = 0.03;
+
+    static bool isModalStage (int stage) { return stage >= modalStage && stage < dryStage; }
+
+    // Everything the bleed path needs at audio rate. It is built off the audio thread the
+    // first time the sidechain carries signal (in prepareToPlay for offline renders), so
+    // template tracks that never get one stay tiny. A long silence releases it only while
+    // the bus is disabled or the transport is stopped, never in the middle of a take.
+    struct BleedEngine
+    {
+        void prepare (const juce::dsp::ProcessSpec& spec);
+        void reset();
+        void resetStage (int stage);
+        void switchStage (int stage, const ResonatorPreset* preset);
+        void processStage (int stage, juce::AudioBuffer<float>& buffer, int numSamples);
+        int getStageLatency (int stage) const;
+
+        CompactDelayLine delayLine;
+        juce::dsp::StateVariableTPTFilter<float> lowcutFilter, hicutFilter, airAbsorptionFilter;
+
+        // Reverb at 1/1, 1/2 and 1/4 of the host rate, three modal banks as stages 3 to 5,
+        // and a plain dry path for ROOM = None as stage 6. The active one is picked from
+        // the room type, HICUT and sample rate and always changes at once. The stage
+        // switched away from keeps running on silence until its tail has died away; if
+        // another switch comes first, that tail is faded out over stageFadeSeconds to free
+        // the slot. A new modal preset goes to a free bank the same way, so no bank has
+        // its coefficients changed while it rings.
+        std::array<ReducedRateReverb, 3> reverbStages;
+        std::array<ResonatorBank, 3> resonatorBanks;
+        int activeReverbStage = 0, drainingReverbStage = -1, fadingReverbStage = -1;
+        int fadeLength = 1, fadeSamplesLeft = 0;
+
+        juce::AudioBuffer<float> bleedBuffer, drainBuffer;
+        juce::AudioBuffer<float> delayModulation; // per-sample delay (ch 0) and distance gain (ch 1)
+        juce::SmoothedValue<float> delaySmoother, distanceAttenuation;
+        bool primed = false;
+    };
+
+    void handleAsyncUpdate() override;
+    static const ResonatorPreset* getResonatorPreset (int roomType);
+    void updateRoomProfile (BleedEngine& engine, int roomType);
+    int chooseReverbStage (const BleedEngine& engine, float hiCutHz) const;
+    static int chooseModalStage (const BleedEngine& engine, const ResonatorPreset& preset);
+    void processReverb (BleedEngine& engine, int numSamples);
+    void readDelayed (BleedEngine& engine, int interpolation, int numSamples);
+    void recordOnset (const juce::AudioBuffer<float>& sidechain, int numSamples);
+    void replayOnset (BleedEngine& engine);
+
+    // Owned. Only the audio thread moves activeEngine to retiredEngine; only the message
+    // thread (under engineLock) installs a new engine or deletes a retired one.
+    std::atomic<BleedEngine*> activeEngine { nullptr }, retiredEngine { nullptr };
+    std::atomic<bool> engineRequested { false };
+    juce::CriticalSection engineLock;
+    juce::dsp::ProcessSpec preparedSpec {};
+    bool isPrepared = false;
+    int idleSamples = 0;
+
+    // Sidechain captured while a requested engine is still being built, replayed into its
+    // delay line on arrival so the first hit still bleeds through. Allocated only when
+    // the sidechain bus is enabled.
+    juce::AudioBuffer<float> onsetBuffer;
+    int onsetWrite = 0, onsetCount = 0;
+
+    juce::SmoothedValue<float> mixGain, extraSidechainGain;
+    std::atomic<bool> legacySpace { false };
+
+   #if ROOMBLEED_PROFILE
+    void processBlockInternal (juce::AudioBuffer<float>&);
+    std::atomic<juce::int64> timedBlocks { 0 }, totalTicks { 0 }, worstTicks { 0 };
+   #endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RoomBleedAudioProcessor)
 };
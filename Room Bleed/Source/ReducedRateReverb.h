@@ -0,0 +1,205 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Polyphase halfband FIR used for the 2:1 decimation and 1:2 interpolation stages
+// around the reduced-rate reverb. Every other tap of a halfband is zero, so each
+// stage only runs the nonzero odd-offset taps plus the 0.5 centre tap.
+class HalfbandFilter
+{
+public:
+    static constexpr int numSideTaps = 12; // 47-tap kernel
+
+    void reset()
+    {
+        std::fill (std::begin (history), std::end (history), 0.0f);
+        std::fill (std::begin (centreHistory), std::end (centreHistory), 0.0f);
+        pos = 0; centrePos = 0;
+    }
+
+    // Two input samples in, one output sample out at half rate.
+    float decimate (float x0, float x1)
+    {
+        // Oldest slot of the centre ring is numSideTaps - 1 half-rate samples back.
+        centreHistory[centrePos] = x0;
+        centrePos = (centrePos + 1 == numSideTaps) ? 0 : centrePos + 1;
+        return 0.5f * centreHistory[centrePos] + push (x1);
+    }
+
+    // One input sample in, two output samples out at double rate.
+    void interpolate (float x, float& y0, float& y1)
+    {
+        y0 = 2.0f * push (x);
+        y1 = history[pos + numSideTaps - 1];
+    }
+
+private:
+    static constexpr int historySize = 2 * numSideTaps;
+
+    static const std::array<float, numSideTaps>& getCoefficients()
+    {
+        static const auto coeffs = []
+        {
+            // Blackman-windowed sinc, normalised so the full kernel has unity DC gain.
+            std::array<float, numSideTaps> c {};
+            const double span = 2.0 * (2 * numSideTaps - 1);
+            double sum = 0.0;
+            for (int i = 0; i < numSideTaps; ++i) {
+                const double d = 2 * i + 1;
+                const double n = span * 0.5 + d;
+                const double w = 0.42 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * n / span)
+                                       + 0.08 * std::cos (2.0 * juce::MathConstants<double>::twoPi * n / span);
+                c[(size_t) i] = (float) (((i & 1) ? -1.0 : 1.0) / (juce::MathConstants<double>::pi * d) * w);
+                sum += c[(size_t) i];
+            }
+            for (auto& v : c)
+                v = (float) (v * 0.25 / sum);
+            return c;
+        }();
+        return coeffs;
+    }
+
+    // Writes x as the newest sample and returns the symmetric side-tap sum.
+    float push (float x)
+    {
+        pos = (pos == 0) ? historySize - 1 : pos - 1;
+        history[pos] = history[pos + historySize] = x;
+
+        const auto& g = getCoefficients();
+        const float* h = history + pos; // h[j] is the sample j steps back
+        float acc = 0.0f;
+        for (int i = 0; i < numSideTaps; ++i)
+            acc += g[(size_t) i] * (h[numSideTaps - 1 - i] + h[numSideTaps + i]);
+        return acc;
+    }
+
+    float history[2 * historySize] {};
+    float centreHistory[numSideTaps] {};
+    int pos = 0, centrePos = 0;
+};
+
+// Stereo juce::dsp::Reverb running at 1/1, 1/2 or 1/4 of the host rate. The bleed
+// path is band-limited by HICUT and air absorption, so at high sample rates there
+// is nothing up top for the reverb to work on.
+class ReducedRateReverb
+{
+public:
+    void prepare (const juce::dsp::ProcessSpec& spec, int stagesToUse)
+    {
+        numStages = stagesToUse;
+        factor = 1 << numStages;
+
+        auto lowSpec = spec;
+        lowSpec.sampleRate = spec.sampleRate / factor;
+        lowSpec.maximumBlockSize = spec.maximumBlockSize / (juce::uint32) factor + 1;
+        lowSpec.numChannels = 2;
+        reverb.prepare (lowSpec);
+
+        lowRateBuffer.setSize (2, (int) lowSpec.maximumBlockSize);
+        fifo.setSize (2, (int) spec.maximumBlockSize + 2 * factor);
+        reset();
+    }
+
+    void reset()
+    {
+        reverb.reset();
+        for (auto& stage : decimators)    for (auto& f : stage) f.reset();
+        for (auto& stage : interpolators) for (auto& f : stage) f.reset();
+        for (auto& p : pendingValid) p = false;
+
+        // Priming with factor - 1 zeros guarantees a full block is always available.
+        fifo.clear();
+        fifoRead = 0;
+        fifoCount = factor - 1;
+    }
+
+    void setParameters (const juce::dsp::Reverb::Parameters& p) { reverb.setParameters (p); }
+    int getFactor() const { return factor; }
+
+    // Group delay of the decimate/interpolate chain in host samples: 2 * 23 per 2:1 stage,
+    // counted at that stage's input rate. Constant for every input phase.
+    int getLatencySamples() const { return 2 * (2 * HalfbandFilter::numSideTaps - 1) * (factor - 1); }
+
+    // Processes the first numSamples of a stereo buffer in place.
+    void process (juce::AudioBuffer<float>& buffer, int numSamples)
+    {
+        if (numStages == 0) {
+            juce::dsp::AudioBlock<float> block (buffer);
+            auto sub = block.getSubBlock (0, (size_t) numSamples);
+            reverb.process (juce::dsp::ProcessContextReplacing<float> (sub));
+            return;
+        }
+
+        float* left = buffer.getWritePointer (0);
+        float* right = buffer.getWritePointer (1);
+        float* lowL = lowRateBuffer.getWritePointer (0);
+        float* lowR = lowRateBuffer.getWritePointer (1);
+        int numLow = 0;
+
+        for (int s = 0; s < numSamples; ++s) {
+            float l = left[s], r = right[s];
+            int stage = 0;
+            for (; stage < numStages; ++stage) {
+                if (! pendingValid[stage]) {
+                    pending[stage][0] = l; pending[stage][1] = r;
+                    pendingValid[stage] = true;
+                    break;
+                }
+                pendingValid[stage] = false;
+                l = decimators[stage][0].decimate (pending[stage][0], l);
+                r = decimators[stage][1].decimate (pending[stage][1], r);
+            }
+            if (stage == numStages) {
+                lowL[numLow] = l; lowR[numLow] = r;
+                ++numLow;
+            }
+        }
+
+        if (numLow > 0) {
+            juce::dsp::AudioBlock<float> block (lowRateBuffer);
+            auto sub = block.getSubBlock (0, (size_t) numLow);
+            reverb.process (juce::dsp::ProcessContextReplacing<float> (sub));
+            for (int i = 0; i < numLow; ++i)
+                pushInterpolated (numStages - 1, lowL[i], lowR[i]);
+        }
+
+        const int capacity = fifo.getNumSamples();
+        const float* fifoL = fifo.getReadPointer (0);
+        const float* fifoR = fifo.getReadPointer (1);
+        for (int s = 0; s < numSamples; ++s) {
+            left[s] = fifoL[fifoRead];
+            right[s] = fifoR[fifoRead];
+            fifoRead = (fifoRead + 1 == capacity) ? 0 : fifoRead + 1;
+        }
+        fifoCount -= numSamples;
+    }
+
+private:
+    static constexpr int maxStages = 2;
+
+    void pushInterpolated (int stage, float l, float r)
+    {
+        if (stage < 0) {
+            const int capacity = fifo.getNumSamples();
+            const int write = (fifoRead + fifoCount) % capacity;
+            fifo.setSample (0, write, l);
+            fifo.setSample (1, write, r);
+            ++fifoCount;
+            return;
+        }
+        float l0, l1, r0, r1;
+        interpolators[stage][0].interpolate (l, l0, l1);
+        interpolators[stage][1].interpolate (r, r0, r1);
+        pushInterpolated (stage - 1, l0, r0);
+        pushInterpolated (stage - 1, l1, r1);
+    }
+
+    juce::dsp::Reverb reverb;
+    int numStages = 0, factor = 1;
+
+    HalfbandFilter decimators[maxStages][2], interpolators[maxStages][2]; // [stage][channel]
+    float pending[maxStages][2] {};
+    bool pendingValid[maxStages] {};
+
+    juce::AudioBuffer<float> lowRateBuffer, fifo;
+    int fifoRead = 0, fifoCount = 0;
+};
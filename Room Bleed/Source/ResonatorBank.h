@@ -0,0 +1,198 @@
+#pragma once
+#include <JuceHeader.h>
+
+struct ResonatorMode
+{
+    float frequency, decaySeconds, gain;
+};
+
+// Mode table plus a short diffuse tail for one small or tubular space.
+struct ResonatorPreset
+{
+    static constexpr int numModes = 16;
+
+    ResonatorMode modes[numModes];
+    float width, tailLevel, tailDecaySeconds;
+};
+
+// Modal engine for spaces dominated by a handful of strong resonances. Each mode is a
+// two-pole resonator with zeros at DC and Nyquist, run a SIMD register's worth of
+// modes at a time, and a pair of allpasses into one damped comb supplies the diffuse
+// part. That is three delay lines per channel against Freeverb's twelve.
+class ResonatorBank
+{
+public:
+    static constexpr int numModes = ResonatorPreset::numModes;
+
+    void prepare (const juce::dsp::ProcessSpec& spec)
+    {
+        sampleRate = spec.sampleRate;
+        for (int ch = 0; ch < 2; ++ch) {
+            for (int i = 0; i < 3; ++i) {
+                tailLength[ch][i] = juce::jmax (1, (int) (tailTimesMs[ch][i] * 0.001 * sampleRate));
+                tailBuffer[ch][i].assign ((size_t) tailLength[ch][i], 0.0f);
+            }
+        }
+        updateCoefficients();
+        reset();
+    }
+
+    void reset()
+    {
+        for (int ch = 0; ch < 2; ++ch) {
+            std::fill (std::begin (y1[ch]), std::end (y1[ch]), 0.0f);
+            std::fill (std::begin (y2[ch]), std::end (y2[ch]), 0.0f);
+            x1[ch] = x2[ch] = 0.0f;
+            combFilterState[ch] = 0.0f;
+            for (int i = 0; i < 3; ++i) {
+                std::fill (tailBuffer[ch][i].begin(), tailBuffer[ch][i].end(), 0.0f);
+                tailPos[ch][i] = 0;
+            }
+        }
+    }
+
+    // Cheap enough to call from the audio thread, but only does work when the preset
+    // changes. Swapping coefficients under a ringing state clicks, so change presets on
+    // a bank that has been reset or is about to be.
+    void setPreset (const ResonatorPreset& newPreset)
+    {
+        if (preset == &newPreset)
+            return;
+        preset = &newPreset;
+        updateCoefficients();
+    }
+
+    const ResonatorPreset* getPreset() const { return preset; }
+
+    // Processes the first numSamples of a stereo buffer in place.
+    void process (juce::AudioBuffer<float>& buffer, int numSamples)
+    {
+        if (preset == nullptr)
+            return;
+
+        for (int ch = 0; ch < 2; ++ch) {
+            float* data = buffer.getWritePointer (ch);
+
+           #if JUCE_USE_SIMD
+            using Vec = juce::dsp::SIMDRegister<float>;
+            constexpr int numVecs = numModes / (int) Vec::SIMDNumElements;
+            Vec a1v[numVecs], a2v[numVecs], bv[numVecs], s1[numVecs], s2[numVecs];
+            for (int v = 0; v < numVecs; ++v) {
+                const int i = v * (int) Vec::SIMDNumElements;
+                a1v[v] = Vec::fromRawArray (a1 + i);
+                a2v[v] = Vec::fromRawArray (a2 + i);
+                bv[v]  = Vec::fromRawArray (b[ch] + i);
+                s1[v]  = Vec::fromRawArray (y1[ch] + i);
+                s2[v]  = Vec::fromRawArray (y2[ch] + i);
+            }
+           #endif
+
+            for (int s = 0; s < numSamples; ++s) {
+                const float x = data[s];
+                const float excitation = x - x2[ch];
+                x2[ch] = x1[ch];
+                x1[ch] = x;
+
+               #if JUCE_USE_SIMD
+                const Vec in = Vec::expand (excitation);
+                Vec acc = Vec::expand (0.0f);
+                for (int v = 0; v < numVecs; ++v) {
+                    const Vec y = bv[v] * in + a1v[v] * s1[v] - a2v[v] * s2[v];
+                    s2[v] = s1[v];
+                    s1[v] = y;
+                    acc += y;
+                }
+                float modal = acc.sum();
+               #else
+                float modal = 0.0f;
+                for (int i = 0; i < numModes; ++i) {
+                    const float y = b[ch][i] * excitation + a1[i] * y1[ch][i] - a2[i] * y2[ch][i];
+                    y2[ch][i] = y1[ch][i];
+                    y1[ch][i] = y;
+                    modal += y;
+                }
+               #endif
+
+                data[s] = modal + tailGain[ch] * processTail (ch, x);
+            }
+
+           #if JUCE_USE_SIMD
+            for (int v = 0; v < numVecs; ++v) {
+                const int i = v * (int) Vec::SIMDNumElements;
+                s1[v].copyToRawArray (y1[ch] + i);
+                s2[v].copyToRawArray (y2[ch] + i);
+            }
+           #endif
+        }
+    }
+
+private:
+    // Roughly matches the level Freeverb puts out for the small rooms these replace.
+    static constexpr float outputLevel = 0.15f;
+    static constexpr float tailDamping = 0.35f;
+
+    // allpass, allpass, comb; the channels differ so the tail decorrelates.
+    static constexpr double tailTimesMs[2][3] = { { 4.7, 1.6, 11.3 }, { 5.3, 1.9, 12.7 } };
+
+    void updateCoefficients()
+    {
+        if (preset == nullptr)
+            return;
+
+        // Each mode is normalised to unit noise-power gain before its table gain is
+        // applied, so broadband input comes out at a level independent of the decays.
+        float gainSum = 0.0f;
+        for (auto& m : preset->modes)
+            gainSum += m.gain * m.gain;
+        const float norm = outputLevel / std::sqrt (juce::jmax (gainSum, 1.0e-6f));
+
+        for (int i = 0; i < numModes; ++i) {
+            const auto& m = preset->modes[i];
+            const bool audible = m.frequency < 0.45 * sampleRate;
+            const double r = std::pow (10.0, -3.0 / (m.decaySeconds * sampleRate));
+            const double w = juce::MathConstants<double>::twoPi * m.frequency / sampleRate;
+
+            a1[i] = (float) (2.0 * r * std::cos (w));
+            a2[i] = (float) (r * r);
+            const float gain = audible ? (float) std::sqrt ((1.0 - r * r) * 0.5) * m.gain * norm : 0.0f;
+            b[0][i] = gain;
+            b[1][i] = (i & 1) ? gain * (1.0f - 2.0f * preset->width) : gain;
+        }
+
+        // The tail gets the same treatment: its comb is normalised to unit noise gain.
+        for (int ch = 0; ch < 2; ++ch) {
+            combFeedback[ch] = (float) std::pow (10.0, -3.0 * tailLength[ch][2] / (preset->tailDecaySeconds * sampleRate));
+            tailGain[ch] = outputLevel * preset->tailLevel * std::sqrt (1.0f - combFeedback[ch] * combFeedback[ch]);
+        }
+    }
+
+    float processTail (int ch, float x)
+    {
+        for (int i = 0; i < 2; ++i) {
+            float& delayed = tailBuffer[ch][i][(size_t) tailPos[ch][i]];
+            const float out = delayed - 0.5f * x;
+            delayed = x + 0.5f * out;
+            x = out;
+            tailPos[ch][i] = (tailPos[ch][i] + 1 == tailLength[ch][i]) ? 0 : tailPos[ch][i] + 1;
+        }
+
+        float& delayed = tailBuffer[ch][2][(size_t) tailPos[ch][2]];
+        const float out = delayed;
+        combFilterState[ch] = out + tailDamping * (combFilterState[ch] - out);
+        delayed = x + combFeedback[ch] * combFilterState[ch];
+        tailPos[ch][2] = (tailPos[ch][2] + 1 == tailLength[ch][2]) ? 0 : tailPos[ch][2] + 1;
+        return out;
+    }
+
+    const ResonatorPreset* preset = nullptr;
+    double sampleRate = 44100.0;
+
+    alignas (32) float a1[numModes] {}, a2[numModes] {};
+    alignas (32) float b[2][numModes] {};
+    alignas (32) float y1[2][numModes] {}, y2[2][numModes] {};
+    float x1[2] {}, x2[2] {};
+
+    std::vector<float> tailBuffer[2][3];
+    int tailLength[2][3] {}, tailPos[2][3] {};
+    float combFeedback[2] {}, combFilterState[2] {}, tailGain[2] {};
+};
@@ -0,0 +1,362 @@
+// Headless session-scale stress host. Builds N Room Bleed instances the way a DAW would,
+// then renders them from a thread pool block by block, paced to real time, while the
+// main thread runs the message loop so engines are built and freed as they would be in
+// a host. Only a fraction of the instances get the shared sidechain; the rest have the
+// bus enabled but silent, or disabled. A playing phase is followed by a stopped-transport
+// phase long enough for idle engines to be released.
+//
+// Reports the cost of instantiation, setStateInformation and prepareToPlay, resident
+// memory per instance, and for each render phase the engines held, the memory change
+// and the total and worst-case block times from the ROOMBLEED_PROFILE hooks.
+//
+//   RoomBleedStressHost [--instances=200] [--threads=<cores>] [--rate=48000] [--block=256]
+//                       [--seconds=10] [--stopped-seconds=65] [--sidechain-percent=25]
+//                       [--disabled-percent=25] [--unpaced] [--seed=1]
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+#include <cstdio>
+
+#if JUCE_LINUX
+ #include <fstream>
+ #include <unistd.h>
+#elif JUCE_MAC
+ #include <mach/mach.h>
+#endif
+
+#if ! ROOMBLEED_PROFILE
+ #error "The stress host reads the per-instance block timings, so build it with ROOMBLEED_PROFILE=1."
+#endif
+
+namespace
+{
+    juce::int64 getResidentBytes()
+    {
+       #if JUCE_LINUX
+        std::ifstream statm ("/proc/self/statm");
+        long totalPages = 0, residentPages = 0;
+        statm >> totalPages >> residentPages;
+        return (juce::int64)residentPages * (juce::int64)sysconf(_SC_PAGESIZE);
+       #elif JUCE_MAC
+        mach_task_basic_info info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+            return 0;
+        return (juce::int64)info.resident_size;
+       #else
+        return 0;
+       #endif
+    }
+
+    int getIntOption (const juce::ArgumentList& args, juce::StringRef option, int defaultValue)
+    {
+        auto value = args.getValueForOption(option);
+        return value.isNotEmpty() ? value.getIntValue() : defaultValue;
+    }
+
+    double toMegabytes (juce::int64 bytes) { return (double)bytes / (1024.0 * 1024.0); }
+
+    struct StressPlayHead  : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying(playing.load());
+            info.setTimeInSamples(samplePosition.load());
+            return info;
+        }
+
+        std::atomic<bool> playing { true };
+        std::atomic<juce::int64> samplePosition { 0 };
+    };
+
+    // How an instance's sidechain is routed for the whole run.
+    enum class Routing { signal, silent, disabled };
+
+    struct Instance
+    {
+        std::unique_ptr<RoomBleedAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::Random random;
+        Routing routing = Routing::silent;
+    };
+
+    struct PhaseResult
+    {
+        std::vector<double> seconds;
+        juce::int64 residentBytesAdded = 0;
+    };
+
+    // Times fn once per instance on the calling thread, as a host's message thread would.
+    template <typename Fn>
+    PhaseResult runPhase (std::vector<Instance>& instances, Fn&& fn)
+    {
+        PhaseResult result;
+        const auto residentBefore = getResidentBytes();
+        for (auto& instance : instances) {
+            const auto start = juce::Time::getHighResolutionTicks();
+            fn(instance);
+            result.seconds.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start));
+        }
+        result.residentBytesAdded = getResidentBytes() - residentBefore;
+        return result;
+    }
+
+    void printPhase (const char* name, const PhaseResult& phase)
+    {
+        const auto n = juce::jmax((size_t)1, phase.seconds.size());
+        double total = 0.0, worst = 0.0;
+        for (auto s : phase.seconds) {
+            total += s;
+            worst = juce::jmax(worst, s);
+        }
+        std::printf("%-22s total %9.2f ms   mean %9.1f us   worst %9.1f us   RSS %+8.2f MB (%+7.1f kB/instance)\n",
+                    name, total * 1.0e3, total / (double)n * 1.0e6, worst * 1.0e6,
+                    toMegabytes(phase.residentBytesAdded), (double)phase.residentBytesAdded / 1024.0 / (double)n);
+    }
+
+    int countEngines (const std::vector<Instance>& instances, Routing routing)
+    {
+        int count = 0;
+        for (auto& instance : instances)
+            count += (instance.routing == routing && instance.processor->hasActiveEngine()) ? 1 : 0;
+        return count;
+    }
+
+    // Decaying noise bursts on every beat at 120 bpm, with a two-second rest in the middle
+    // so the silence detection runs as well as the bleed itself.
+    juce::AudioBuffer<float> makeSidechain (double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> sidechain (2, numSamples);
+        juce::Random random (1);
+        const int beat = (int)(sampleRate * 0.5);
+        const int restStart = numSamples / 2, restEnd = restStart + (int)(sampleRate * 2.0);
+        const float decay = (float)std::exp(-1.0 / (0.05 * sampleRate));
+        float envelope = 0.0f;
+        for (int s = 0; s < numSamples; ++s) {
+            if (s % beat == 0 && (s < restStart || s >= restEnd))
+                envelope = 0.8f;
+            envelope *= decay;
+            for (int ch = 0; ch < 2; ++ch)
+                sidechain.setSample(ch, s, envelope * (random.nextFloat() * 2.0f - 1.0f));
+        }
+        return sidechain;
+    }
+
+    juce::AudioBuffer<float> makeMainInput (double sampleRate, int numSamples)
+    {
+        juce::AudioBuffer<float> main (2, numSamples);
+        for (int s = 0; s < numSamples; ++s) {
+            const float x = 0.1f * (float)std::sin(juce::MathConstants<double>::twoPi * 220.0 * s / sampleRate);
+            main.setSample(0, s, x);
+            main.setSample(1, s, x);
+        }
+        return main;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption("--help|-h")) {
+        std::printf("usage: %s [--instances=200] [--threads=N] [--rate=48000] [--block=256] [--seconds=10]\n"
+                    "       [--stopped-seconds=65] [--sidechain-percent=25] [--disabled-percent=25] [--unpaced] [--seed=1]\n",
+                    args.executableName.toRawUTF8());
+        return 0;
+    }
+
+    const int numInstances = juce::jmax(1, getIntOption(args, "--instances", 200));
+    const int numThreads = juce::jmax(1, getIntOption(args, "--threads", juce::SystemStats::getNumCpus()));
+    const double sampleRate = (double)getIntOption(args, "--rate", 48000);
+    const int blockSize = juce::jmax(1, getIntOption(args, "--block", 256));
+    const int playingBlocks = juce::jmax(1, (int)(getIntOption(args, "--seconds", 10) * sampleRate) / blockSize);
+    const int stoppedBlocks = juce::jmax(0, (int)(getIntOption(args, "--stopped-seconds", 65) * sampleRate) / blockSize);
+    const int signalPercent = juce::jlimit(0, 100, getIntOption(args, "--sidechain-percent", 25));
+    const int disabledPercent = juce::jlimit(0, 100 - signalPercent, getIntOption(args, "--disabled-percent", 25));
+    const bool paced = ! args.containsOption("--unpaced");
+    const int seed = getIntOption(args, "--seed", 1);
+
+    std::vector<Instance> instances ((size_t)numInstances);
+    const int numSignal = numInstances * signalPercent / 100;
+    const int numDisabled = numInstances * disabledPercent / 100;
+    for (int i = 0; i < numInstances; ++i) {
+        auto& instance = instances[(size_t)i];
+        instance.random.setSeed(seed * 100003 + i);
+        instance.routing = i < numSignal ? Routing::signal
+                         : i < numSignal + numDisabled ? Routing::disabled
+                         : Routing::silent;
+    }
+
+    std::printf("Room Bleed stress host: %d instances (%d with sidechain signal, %d silent, %d bus disabled),\n"
+                "%d threads, %.0f Hz, %d-sample blocks, %.1f s playing then %.1f s stopped, %s\n\n",
+                numInstances, numSignal, numInstances - numSignal - numDisabled, numDisabled,
+                numThreads, sampleRate, blockSize, playingBlocks * blockSize / sampleRate,
+                stoppedBlocks * blockSize / sampleRate, paced ? "paced to real time" : "unpaced");
+
+    StressPlayHead playHead;
+
+    auto instantiate = runPhase(instances, [] (Instance& instance) {
+        instance.processor = std::make_unique<RoomBleedAudioProcessor>();
+    });
+    printPhase("instantiate", instantiate);
+
+    // Each instance gets its own random session. Only the restore itself is timed.
+    std::vector<juce::MemoryBlock> states ((size_t)numInstances);
+    for (int i = 0; i < numInstances; ++i) {
+        auto& instance = instances[(size_t)i];
+        for (auto* param : instance.processor->getParameters())
+            param->setValueNotifyingHost(instance.random.nextFloat());
+        instance.processor->getStateInformation(states[(size_t)i]);
+    }
+    int stateIndex = 0;
+    auto setState = runPhase(instances, [&] (Instance& instance) {
+        auto& state = states[(size_t)stateIndex++];
+        instance.processor->setStateInformation(state.getData(), (int)state.getSize());
+    });
+    printPhase("setStateInformation", setState);
+
+    auto prepare = runPhase(instances, [&] (Instance& instance) {
+        auto& p = *instance.processor;
+        if (instance.routing == Routing::disabled) {
+            auto layout = p.getBusesLayout();
+            layout.inputBuses.getReference(1) = juce::AudioChannelSet::disabled();
+            p.setBusesLayout(layout);
+        }
+        p.setPlayHead(&playHead);
+        p.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        p.prepareToPlay(sampleRate, blockSize);
+        instance.buffer.setSize(juce::jmax(p.getTotalNumInputChannels(), p.getTotalNumOutputChannels()), blockSize);
+    });
+    printPhase("prepareToPlay", prepare);
+    std::printf("%-22s engines held: %d with signal, %d silent, %d disabled\n\n", "",
+                countEngines(instances, Routing::signal), countEngines(instances, Routing::silent),
+                countEngines(instances, Routing::disabled));
+
+    const int totalBlocks = playingBlocks + stoppedBlocks;
+    const auto sidechain = makeSidechain(sampleRate, playingBlocks * blockSize);
+    const auto mainInput = makeMainInput(sampleRate, totalBlocks * blockSize);
+    const int automationInterval = juce::jmax(1, juce::roundToInt(sampleRate / blockSize)); // about once a second
+
+    // The sidechain only plays while the transport does; stopped blocks carry silence.
+    auto processInstance = [&] (Instance& instance, int start, bool playing) {
+        auto& p = *instance.processor;
+
+        // Host-style automation: now and then one parameter jumps to a new value.
+        if (playing && instance.random.nextInt(automationInterval) == 0) {
+            auto& params = p.getParameters();
+            params[instance.random.nextInt(params.size())]->setValueNotifyingHost(instance.random.nextFloat());
+        }
+
+        instance.buffer.clear();
+        for (int ch = 0; ch < 2; ++ch) {
+            instance.buffer.copyFrom(ch, 0, mainInput, ch, start, blockSize);
+            if (playing && instance.routing == Routing::signal && instance.buffer.getNumChannels() > 2 + ch)
+                instance.buffer.copyFrom(2 + ch, 0, sidechain, ch, start, blockSize);
+        }
+
+        const juce::ScopedLock sl (p.getCallbackLock());
+        p.processBlock(instance.buffer, instance.midi);
+    };
+
+    // One cycle per block: every instance has to finish before the next block starts, the
+    // way a host's audio callback waits on its worker threads. This runs on its own thread
+    // so the main thread is free to run the message loop that builds and frees engines.
+    juce::ThreadPool pool (juce::ThreadPoolOptions{}.withThreadName("Room Bleed stress").withNumberOfThreads(numThreads));
+    juce::WaitableEvent renderDone;
+
+    auto renderPhase = [&] (const char* name, int firstBlock, int numBlocks, bool playing) {
+        if (numBlocks == 0)
+            return;
+
+        playHead.playing = playing;
+        for (auto& instance : instances)
+            instance.processor->resetBlockTimingStats();
+
+        std::atomic<int> nextInstance { 0 }, pendingJobs { 0 };
+        juce::WaitableEvent cycleDone;
+        const double blockBudget = blockSize / sampleRate;
+        double worstCycle = 0.0, totalCycles = 0.0;
+        int overBudget = 0;
+
+        const auto residentBefore = getResidentBytes();
+        const auto phaseStart = juce::Time::getHighResolutionTicks();
+        for (int block = firstBlock; block < firstBlock + numBlocks; ++block) {
+            const int start = block * blockSize;
+            playHead.samplePosition = start;
+            nextInstance = 0;
+            pendingJobs = numThreads;
+
+            const auto cycleStart = juce::Time::getHighResolutionTicks();
+            for (int t = 0; t < numThreads; ++t) {
+                pool.addJob([&, start] {
+                    for (int i = nextInstance++; i < numInstances; i = nextInstance++)
+                        processInstance(instances[(size_t)i], start, playing);
+                    if (--pendingJobs == 0)
+                        cycleDone.signal();
+                });
+            }
+            cycleDone.wait();
+
+            const auto now = juce::Time::getHighResolutionTicks();
+            const double cycle = juce::Time::highResolutionTicksToSeconds(now - cycleStart);
+            totalCycles += cycle;
+            worstCycle = juce::jmax(worstCycle, cycle);
+            overBudget += cycle > blockBudget ? 1 : 0;
+
+            if (paced) {
+                const double ahead = (block - firstBlock + 1) * blockBudget - juce::Time::highResolutionTicksToSeconds(now - phaseStart);
+                if (ahead >= 0.001)
+                    juce::Thread::sleep((int)(ahead * 1000.0));
+            }
+        }
+
+        double totalDsp = 0.0, worstBlock = 0.0;
+        juce::int64 timedBlocks = 0;
+        int worstInstance = 0;
+        for (int i = 0; i < numInstances; ++i) {
+            const auto stats = instances[(size_t)i].processor->getBlockTimingStats();
+            totalDsp += stats.totalSeconds;
+            timedBlocks += stats.numBlocks;
+            if (stats.worstSeconds > worstBlock) {
+                worstBlock = stats.worstSeconds;
+                worstInstance = i;
+            }
+        }
+
+        const double audioSeconds = numBlocks * blockBudget;
+        std::printf("%-22s total %9.2f ms   mean %9.2f us/block   worst %9.1f us (instance %d)\n",
+                    name, totalDsp * 1.0e3, totalDsp / (double)juce::jmax((juce::int64)1, timedBlocks) * 1.0e6, worstBlock * 1.0e6, worstInstance);
+        std::printf("%-22s %.3f cores of DSP for %.1f s of audio, %.3f%% of one core per instance\n",
+                    "", totalDsp / audioSeconds, audioSeconds, totalDsp / audioSeconds / numInstances * 100.0);
+        std::printf("%-22s worst cycle %.3f ms, mean %.3f ms, budget %.3f ms, %d of %d cycles over budget\n",
+                    "", worstCycle * 1.0e3, totalCycles / numBlocks * 1.0e3, blockBudget * 1.0e3, overBudget, numBlocks);
+        std::printf("%-22s engines held: %d of %d with signal, %d of %d silent, %d of %d disabled; RSS %+.2f MB\n\n",
+                    "", countEngines(instances, Routing::signal), numSignal,
+                    countEngines(instances, Routing::silent), numInstances - numSignal - numDisabled,
+                    countEngines(instances, Routing::disabled), numDisabled,
+                    toMegabytes(getResidentBytes() - residentBefore));
+    };
+
+    juce::Thread::launch([&] {
+        renderPhase("playing", 0, playingBlocks, true);
+        renderPhase("stopped", playingBlocks, stoppedBlocks, false);
+        renderDone.signal();
+        juce::MessageManager::getInstance()->stopDispatchLoop();
+    });
+
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    renderDone.wait();
+
+    auto teardown = runPhase(instances, [] (Instance& instance) {
+        instance.processor->releaseResources();
+        instance.processor.reset();
+    });
+    printPhase("release + delete", teardown);
+
+    std::printf("\nresident now %.2f MB\n", toMegabytes(getResidentBytes()));
+    return 0;
+}